@@ -22,6 +22,7 @@
 #include <ctime>
 #include <cstdlib>
 #include "Application.h"
+#include "Tuning.h"
 
 int main(int argc, char** argv)
 {
@@ -52,6 +53,15 @@ void Application::onStart()
         << "      start=HH:MM    (current moment if omitted)" << std::endl
         << "      end=HH:MM      (until application is killed if omitted)" << std::endl
         << "      pids=N1,N2,... (using decimal, hexadecimal or octal numbers; by default all PIDs)" << std::endl
+        << "  Capture thread options (for loaded hosts):" << std::endl
+        << "      rxcpus=LIST    (pin the receptor thread to CPUs, e.g. 2 or 2,3 or 0-3)" << std::endl
+        << "      wrcpus=LIST    (pin the writer thread to CPUs; better apart from the receptor ones)" << std::endl
+        << "      rxnode=N       (instead of rxcpus: the CPUs of the NUMA node N available to this process)" << std::endl
+        << "      wrnode=N       (instead of wrcpus: the CPUs of the NUMA node N available to this process)" << std::endl
+        << "                     (only CPU placement: the memory follows the default first-touch policy)" << std::endl
+        << "      rxsched=fifo:P (receptor real-time scheduling SCHED_FIFO or 'rr:P' for SCHED_RR, priority P)" << std::endl
+        << "      mlock=1        (lock in memory the receptor stack and a pool of reception buffers)" << std::endl
+        << "      latency=1      (report every minute and at exit the full-buffer reads and the receptor run queue delay)" << std::endl
         << std::endl
         << "  Terrestrial and Satellite options (always numeric):" << std::endl
         << "      17 (DTV_DELIVERY_SYSTEM), 3 (DTV_FREQUENCY), 6 (DTV_INVERSION), 4 (DTV_MODULATION)" << std::endl
@@ -112,6 +122,37 @@ void Application::onStart()
                     config->pids.emplace_back(uint16_t(pv));
                 }
             }
+            else if ((code == "rxcpus") || (code == "wrcpus"))
+            {
+                auto& cpus = (code == "rxcpus")? config->receptorCpus : config->writerCpus;
+                if (!cpus.empty()) throw std::runtime_error("cpus already chosen for that thread (at '" + option + "')");
+                cpus = Tuning::parseCpuList(value);
+            }
+            else if ((code == "rxnode") || (code == "wrnode"))
+            {
+                uint32_t node;
+                if (!(std::stringstream(value) >> node)) throw std::runtime_error("bad node number");
+                auto& cpus = (code == "rxnode")? config->receptorCpus : config->writerCpus;
+                if (!cpus.empty()) throw std::runtime_error("cpus already chosen for that thread (at '" + option + "')");
+                cpus = Tuning::nodeCpus(node);
+            }
+            else if (code == "rxsched")
+            {
+                std::stringstream ps(value);
+                std::string policy;
+                std::getline(ps, policy, ':');
+                if (policy == "fifo") config->receptorPolicy = SCHED_FIFO;
+                else if (policy == "rr") config->receptorPolicy = SCHED_RR;
+                else throw std::runtime_error("bad scheduling policy '" + policy + "'");
+                if (!(ps >> config->receptorPriority) || !ps.eof()
+                    || (config->receptorPriority < sched_get_priority_min(config->receptorPolicy))
+                    || (config->receptorPriority > sched_get_priority_max(config->receptorPolicy)))
+                    throw std::runtime_error("bad scheduling priority");
+            }
+            else if (code == "mlock")
+                { if (!(std::stringstream(value) >> config->lockMemory)) throw std::runtime_error("bad mlock value"); }
+            else if (code == "latency")
+                { if (!(std::stringstream(value) >> config->latencyReport)) throw std::runtime_error("bad latency value"); }
             else // numeric property
             {
                 Config::Property p;
@@ -121,6 +162,21 @@ void Application::onStart()
             }
         }
 
+        for (auto cpus : { &config->receptorCpus, &config->writerCpus })
+        {
+            cpus->sort();
+            cpus->unique();
+            if (!Tuning::allowedCpus(*cpus)) throw std::runtime_error("cpus not available to this process");
+        }
+
+        if ((config->receptorPolicy != SCHED_OTHER)
+            && !Tuning::schedulable(config->receptorPolicy, config->receptorPriority))
+            throw std::runtime_error("real-time scheduling not permitted (raise the rtprio limit or grant CAP_SYS_NICE)");
+
+        if (config->lockMemory && !Tuning::lockable(DVBReceptor::lockedBytes()))
+            throw std::runtime_error("mlock needs " + std::to_string(DVBReceptor::lockedBytes() / 1024)
+                                     + " KB of lockable memory (raise 'ulimit -l' or the memlock limit)");
+
         auto seconds = std::time(nullptr);
         struct tm* tmm = std::localtime(&seconds);
         auto nowIs = tmm->tm_hour * 3600 + tmm->tm_min * 60 + tmm->tm_sec;
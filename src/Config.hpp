@@ -23,6 +23,7 @@
 #include <string>
 #include <cstdint>
 #include <list>
+#include <sched.h>
 
 struct Config
 {
@@ -32,7 +33,8 @@ struct Config
         uint32_t value;
     };
 
-    Config() : adapter(0), frontend(0), demux(0), dvr(0) {}
+    Config() : adapter(0), frontend(0), demux(0), dvr(0),
+               receptorPolicy(SCHED_OTHER), receptorPriority(0), lockMemory(false), latencyReport(false) {}
     uint32_t adapter;
     uint32_t frontend;
     uint32_t demux;
@@ -40,6 +42,12 @@ struct Config
     std::string outputFile;
     std::list<Property> properties;
     std::list<uint16_t> pids;
+    std::list<uint32_t> receptorCpus; // empty for no pinning
+    std::list<uint32_t> writerCpus;
+    int receptorPolicy;               // the writer always keeps the normal scheduling
+    int receptorPriority;
+    bool lockMemory;
+    bool latencyReport;
 };
 
 #endif /* CONFIG_HPP */
@@ -21,24 +21,72 @@
 #include <linux/dvb/dmx.h>
 
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <stropts.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <memory>
+#include <new>
 #include <sys++/String.hpp>
 #include "Config.hpp"
 #include "Application.h"
 #include "DVBReceptor.h"
+#include "Tuning.h"
 
 #define BUFFER_SIZE 65536  // about 26 milliseconds worth of data
+#define POOL_BUFFERS 64    // locked buffers: beyond them a writer backlog takes ordinary (pageable) memory
+#define REPORT_FREQ 60     // seconds (without end= the process is just killed, so the report must not wait for it)
+#define STACK_LOCK 65536   // TLS, thread descriptor and thread startup take about 5 KB; the receive path far less
 
 template <> void DVBReceptor::onMessage(std::shared_ptr<Config>& config)
 {
     writer->send(config);
 
+    if (!config->receptorCpus.empty() && !Tuning::pinThread(config->receptorCpus))
+    {
+        fatalProblem("FATAL: error setting the receptor CPU affinity");
+        return;
+    }
+
+    if ((config->receptorPolicy != SCHED_OTHER) && !Tuning::realtimeThread(config->receptorPolicy, config->receptorPriority))
+    {
+        fatalProblem("FATAL: error setting the receptor real-time scheduling");
+        return;
+    }
+
+    if (config->lockMemory) // after the pinning: pages first touched here are placed next to those CPUs
+    {
+        if (!Tuning::lockStack(STACK_LOCK))
+        {
+            fatalProblem("FATAL: error locking the receptor stack");
+            return;
+        }
+        for (int i = 0; i < POOL_BUFFERS; i++)
+        {
+            pool.emplace_back(std::make_shared<Buffer>(BUFFER_SIZE));
+            if (mlock(pool.back()->data, pool.back()->size) < 0)
+            {
+                fatalProblem("FATAL: error locking the reception buffers");
+                return;
+            }
+        }
+    }
+
+    if (config->latencyReport)
+    {
+        schedstat_fd = Tuning::openRunDelay();
+        if (schedstat_fd >= 0)
+        {
+            latencyReport = true;
+            lastReport = std::chrono::steady_clock::now();
+        }
+        else writer->send(Notif { "latency report unavailable", VA_STR(": " << strerror(errno)) });
+    }
+
     frontend_fd = open(VA_STR("/dev/dvb/adapter" << config->adapter << "/frontend" << config->frontend).c_str(), O_RDWR);
 
     if (frontend_fd < 0)
@@ -143,9 +191,34 @@ template <> void DVBReceptor::onMessage(std::shared_ptr<Config>& config)
 
 template <> void DVBReceptor::onTimer(const bool&)
 {
-    auto buffer = std::make_shared<Buffer>(BUFFER_SIZE);
+    std::shared_ptr<Buffer> buffer;
+    try
+    {
+        buffer = nextBuffer();
+    }
+    catch (const std::bad_alloc&)
+    {
+        errno = ENOMEM;
+        fatalProblem("FATAL: no memory for reception buffers");
+        return;
+    }
+
     auto bytes = read(dvr_fd, buffer->data, buffer->size);
 
+    if (latencyReport && (bytes > 0)) // run queue delay accrued since the previous read
+    {
+        auto delay = Tuning::runDelay(schedstat_fd);
+        if ((delay >= 0) && (lastDelay >= 0)) delays.add(delay - lastDelay, bytes == (decltype(bytes)) buffer->size);
+        lastDelay = delay;
+
+        auto nowIs = std::chrono::steady_clock::now();
+        if (nowIs - lastReport >= std::chrono::seconds(REPORT_FREQ))
+        {
+            writer->send(Notif { "receptor run queue delay", delays.report() }); // cumulative since the start
+            lastReport = nowIs;
+        }
+    }
+
     if (bytes <= 0) fatalProblem("error receiving data");
     else
     {
@@ -156,10 +229,34 @@ template <> void DVBReceptor::onTimer(const bool&)
 
 void DVBReceptor::onStop()
 {
+    if (latencyReport && delays.samples) writer->send(Notif { "final receptor run queue delay", delays.report() });
+    if (schedstat_fd >= 0) close(schedstat_fd);
     writer->waitIdle();
+    for (const auto& buffer : pool) munlock(buffer->data, buffer->size);
     app.reset();
 }
 
+std::shared_ptr<Buffer> DVBReceptor::nextBuffer()
+{
+    for (std::size_t i = 0; i < pool.size(); i++)
+    {
+        const auto& candidate = pool[poolNext];
+        poolNext = (poolNext + 1) % pool.size();
+        if (candidate.use_count() == 1) // no longer queued in (nor being written by) the writer
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return candidate;
+        }
+    }
+    return std::make_shared<Buffer>(BUFFER_SIZE);
+}
+
+std::size_t DVBReceptor::lockedBytes()
+{
+    std::size_t page = sysconf(_SC_PAGESIZE);
+    return POOL_BUFFERS * (BUFFER_SIZE + page) + STACK_LOCK + page; // unaligned buffers may span an extra page
+}
+
 void DVBReceptor::fatalProblem(const char* subject, int unknownError)
 {
     std::string problem = strerror(errno? errno : unknownError);
@@ -167,3 +264,28 @@ void DVBReceptor::fatalProblem(const char* subject, int unknownError)
     app->send(DVBFatal{});
     timerStop(true);
 }
+
+void DelayHistogram::add(int64_t nanoseconds, bool fullBuffer)
+{
+    auto us = nanoseconds / 1000;
+    std::size_t bucket = 0;
+    while ((bucket < sizeof(buckets) / sizeof(buckets[0]) - 1) && (us >= (int64_t(1) << bucket))) bucket++;
+    buckets[bucket]++;
+    samples++;
+    if (fullBuffer) fullReads++;
+    if (us > longest) longest = us;
+}
+
+std::string DelayHistogram::report() const
+{
+    std::string lines = VA_STR(": " << fullReads << " of " << samples << " reads found the buffer full (data backlog), "
+                                    << "longest delay " << longest << " us");
+    const std::size_t last = sizeof(buckets) / sizeof(buckets[0]) - 1;
+    for (std::size_t bucket = 0; bucket <= last; bucket++)
+    {
+        if (!buckets[bucket]) continue;
+        if (bucket < last) lines += VA_STR("\n  < " << (int64_t(1) << bucket) << " us: " << buckets[bucket]);
+        else lines += VA_STR("\n  >= " << (int64_t(1) << (bucket - 1)) << " us: " << buckets[bucket]);
+    }
+    return lines;
+}
@@ -20,23 +20,51 @@
 #define DVBRECEPTOR_H
 
 #include <cerrno>
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
 #include <list>
+#include <string>
+#include <vector>
 #include <sys++/ActorThread.hpp>
 #include "Writer.h"
 
 struct DVBFatal {};
 
+struct DelayHistogram // run queue delay of the receptor: time it was ready to receive but not given a CPU
+{
+    DelayHistogram() : buckets(), samples(0), fullReads(0), longest(0) {}
+
+    void add(int64_t nanoseconds, bool fullBuffer);
+
+    std::string report() const;
+
+    uint64_t buckets[24]; // bucket N counts delays below 2^N microseconds (the last one: all the remaining)
+    uint64_t samples;     // one per dvr read
+    uint64_t fullReads;   // the buffer was filled: the kernel already had more data waiting
+    int64_t longest;      // microseconds
+};
+
 class DVBReceptor : public ActorThread<DVBReceptor>
 {
     friend ActorThread<DVBReceptor>;
 
-    DVBReceptor(const std::shared_ptr<class Application>& parent) : app(parent), writer(Writer::create()) {}
+  public:
+
+    static std::size_t lockedBytes(); // memory to be locked by the mlock option
+
+  private:
+
+    DVBReceptor(const std::shared_ptr<class Application>& parent)
+        : app(parent), writer(Writer::create(parent)), poolNext(0), latencyReport(false), schedstat_fd(-1), lastDelay(-1) {}
 
     template <typename Any> void onMessage(Any&);
     template <typename Any> void onTimer(const Any&);
 
     void onStop();
 
+    std::shared_ptr<Buffer> nextBuffer();
+
     void fatalProblem(const char* subject, int unknownError = EINVAL);
 
     ActorThread<class Application>::ptr app;
@@ -46,6 +74,15 @@ class DVBReceptor : public ActorThread<DVBReceptor>
     int frontend_fd;
     std::list<int> demux_fds;
     int dvr_fd;
+
+    std::vector<std::shared_ptr<Buffer>> pool; // locked buffers reused once the writer releases them
+    std::size_t poolNext;
+
+    bool latencyReport;
+    int schedstat_fd;
+    int64_t lastDelay;
+    DelayHistogram delays;
+    std::chrono::steady_clock::time_point lastReport;
 };
 
 #endif /* DVBRECEPTOR_H */
@@ -0,0 +1,164 @@
+/*
+ *  DVB Jet - Utility to capture multiplexed MPEG-TS files from raw DVB sources
+ *  Copyright 2016 Ciriaco Garcia de Celis
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <pthread.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "Tuning.h"
+
+std::list<uint32_t> Tuning::parseCpuList(const std::string& list)
+{
+    std::list<uint32_t> cpus;
+    if (list.empty() || (list.back() == ',')) throw std::runtime_error("bad cpu list '" + list + "'");
+    std::istringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ','))
+    {
+        char *pend = nullptr;
+        auto first = std::strtol(range.c_str(), &pend, 10);
+        auto last = first;
+        if (*pend == '-')
+        {
+            const char* second = pend + 1;
+            last = std::strtol(second, &pend, 10);
+            if (pend == second) last = -1; // missing upper bound
+        }
+        if (range.empty() || *pend || (first < 0) || (last < first) || (last >= CPU_SETSIZE))
+            throw std::runtime_error("bad cpu list '" + list + "'");
+        for (auto cpu = first; cpu <= last; cpu++) cpus.emplace_back(uint32_t(cpu));
+    }
+    return cpus;
+}
+
+std::list<uint32_t> Tuning::nodeCpus(uint32_t node)
+{
+    std::ifstream sysfs("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string list;
+    if (!std::getline(sysfs, list)) throw std::runtime_error("unknown NUMA node " + std::to_string(node));
+    std::list<uint32_t> cpus;
+    if (!list.empty()) cpus = parseCpuList(list);
+    cpus.remove_if([](uint32_t cpu) { return !allowedCpus({ cpu }); }); // e.g. a container cpuset
+    if (cpus.empty()) throw std::runtime_error("NUMA node " + std::to_string(node) + " has no CPUs available");
+    return cpus;
+}
+
+bool Tuning::allowedCpus(const std::list<uint32_t>& cpus)
+{
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) < 0) return false;
+    for (auto cpu : cpus) if (!CPU_ISSET(cpu, &mask)) return false;
+    return true;
+}
+
+bool Tuning::pinThread(const std::list<uint32_t>& cpus)
+{
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (auto cpu : cpus) CPU_SET(cpu, &mask);
+    int error = pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+    if (error) errno = error;
+    return !error;
+}
+
+bool Tuning::realtimeThread(int policy, int priority)
+{
+    struct sched_param param;
+    param.sched_priority = priority;
+    int error = pthread_setschedparam(pthread_self(), policy, &param);
+    if (error) errno = error;
+    return !error;
+}
+
+bool Tuning::schedulable(int policy, int priority)
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_RTPRIO, &limit) < 0) return false;
+    if ((limit.rlim_cur == RLIM_INFINITY) || (limit.rlim_cur >= rlim_t(priority))) return true;
+
+    bool allowed = false; // probed in a disposable thread (the policy can not be applied to the caller)
+    std::thread probe([&] { allowed = realtimeThread(policy, priority); });
+    probe.join();
+    return allowed;
+}
+
+bool Tuning::lockStack(std::size_t bytes)
+{
+    pthread_attr_t attr;
+    int error = pthread_getattr_np(pthread_self(), &attr);
+    if (error)
+    {
+        errno = error;
+        return false;
+    }
+    void* base;
+    std::size_t size;
+    error = pthread_attr_getstack(&attr, &base, &size);
+    pthread_attr_destroy(&attr);
+    if (error)
+    {
+        errno = error;
+        return false;
+    }
+    if (bytes > size) bytes = size;
+    return mlock(static_cast<char*>(base) + size - bytes, bytes) == 0; // stacks grow downwards
+}
+
+int Tuning::openRunDelay()
+{
+    auto path = "/proc/self/task/" + std::to_string(syscall(SYS_gettid)) + "/schedstat";
+    return open(path.c_str(), O_RDONLY);
+}
+
+int64_t Tuning::runDelay(int fd)
+{
+    char stats[128]; // "on-cpu nanoseconds" "run queue nanoseconds" "timeslices"
+    auto bytes = pread(fd, stats, sizeof(stats) - 1, 0);
+    if (bytes <= 0) return -1;
+    stats[bytes] = 0;
+    char* pend = nullptr;
+    std::strtoull(stats, &pend, 10);
+    if (pend == stats) return -1;
+    const char* second = pend;
+    auto delay = std::strtoull(second, &pend, 10);
+    return (pend == second)? -1 : int64_t(delay);
+}
+
+bool Tuning::lockable(std::size_t bytes)
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_MEMLOCK, &limit) < 0) return false;
+    if ((limit.rlim_cur == RLIM_INFINITY) || (limit.rlim_cur >= bytes)) return true;
+
+    void* probe = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (probe == MAP_FAILED) return false;
+    bool locked = mlock(probe, bytes) == 0; // the limit does not apply to privileged processes
+    munmap(probe, bytes);
+    return locked;
+}
@@ -0,0 +1,48 @@
+/*
+ *  DVB Jet - Utility to capture multiplexed MPEG-TS files from raw DVB sources
+ *  Copyright 2016 Ciriaco Garcia de Celis
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TUNING_H
+#define TUNING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <list>
+
+namespace Tuning // thread placement and memory residency (a descheduled receptor overflows the kernel demux buffer)
+{
+    std::list<uint32_t> parseCpuList(const std::string& list); // kernel syntax "0,2-5" (throws std::runtime_error)
+    std::list<uint32_t> nodeCpus(uint32_t node);                // CPUs of a NUMA node available to the process
+                                                                // (throws std::runtime_error if none)
+    bool allowedCpus(const std::list<uint32_t>& cpus);          // all of them within the process affinity mask
+
+    // Applied to the calling thread; errno is set on failure
+    bool pinThread(const std::list<uint32_t>& cpus);
+    bool realtimeThread(int policy, int priority);
+
+    bool schedulable(int policy, int priority); // within RLIMIT_RTPRIO or otherwise allowed (e.g. CAP_SYS_NICE)
+
+    bool lockStack(std::size_t bytes); // the highest (first used) part of the stack, including the thread's TLS block
+
+    int openRunDelay();                // the kernel scheduler statistics of the calling thread (-1 on failure)
+    int64_t runDelay(int fd);          // nanoseconds spent runnable but waiting for a CPU (-1 on failure)
+
+    bool lockable(std::size_t bytes);  // within RLIMIT_MEMLOCK or otherwise allowed (e.g. CAP_IPC_LOCK)
+}
+
+#endif /* TUNING_H */
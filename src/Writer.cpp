@@ -24,13 +24,24 @@
 #include <cstring>
 #include <sys++/String.hpp>
 #include "Config.hpp"
+#include "Application.h"
 #include "Writer.h"
+#include "Tuning.h"
 
 #define NOTIF_FREQ 5 // seconds
 
 template <> void Writer::onMessage(std::shared_ptr<Config>& config)
 {
     outputFile = config->outputFile;
+
+    if (!config->writerCpus.empty() && !Tuning::pinThread(config->writerCpus))
+    {
+        std::string problem = strerror(errno);
+        writeNotif({ "FATAL: error setting the writer CPU affinity", VA_STR(": " << problem) });
+        app->send(DVBFatal{});
+        return;
+    }
+
     timerStart(true, std::chrono::seconds(NOTIF_FREQ), TimerCycle::Periodic);
 }
 
@@ -74,6 +85,11 @@ template <> void Writer::onMessage(std::shared_ptr<Buffer>& buffer)
     }
 }
 
+void Writer::onStop()
+{
+    app.reset();
+}
+
 template <> void Writer::onMessage(Notif& notif) // errors from other threads
 {
     writeNotif(notif);
@@ -66,13 +66,17 @@ class Writer : public ActorThread<Writer> // a dedicated thread so data is not l
 {
     friend ActorThread<Writer>;
 
-    Writer() : fd(-1), inError(false), dispatchBusy(false) {}
+    Writer(const std::shared_ptr<class Application>& parent) : app(parent), fd(-1), inError(false), dispatchBusy(false) {}
 
     template <typename Any> void onMessage(Any&);
     void onTimer(const bool&);
 
+    void onStop();
+
     void writeNotif(const Notif& notif);
 
+    ActorThread<class Application>::ptr app;
+
     std::string outputFile;
     int fd;
     bool inError;